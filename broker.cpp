@@ -0,0 +1,213 @@
+#include "broker.h"
+
+#include <iostream>
+
+#include <tinytemplate.hpp>
+
+Broker::Broker(const Endpoint &endpoint, const std::vector<std::string> &subscriptions, MessageHandler onMessage, StateHandler onStateChanged)
+    : endpoint(endpoint)
+    , subscriptions(subscriptions)
+    , messageHandler(onMessage)
+    , stateHandler(onStateChanged)
+    , mqttClient(nullptr, &mosquitto_destroy)
+    , curConnectionState(connection::off)
+    , connectionError(0)
+    , connected(false)
+    , failed(false)
+{
+}
+
+Broker::~Broker()
+{
+    disconnect();
+}
+
+void Broker::connect()
+{
+    mqttClient.reset(mosquitto_new(nullptr, true, this));
+
+    mosquitto_connect_callback_set(mqttClient.get(), &Broker::onMqttConnect);
+    mosquitto_disconnect_callback_set(mqttClient.get(), &Broker::onMqttDisconnect);
+    mosquitto_message_callback_set(mqttClient.get(), &Broker::onMqttMessage);
+    // Non-forced loop stop waits out the reconnect sleep, so keep it short
+    mosquitto_reconnect_delay_set(mqttClient.get(), 1, 5, true);
+
+    if(!endpoint.username.empty()) {
+        mosquitto_username_pw_set(mqttClient.get(), endpoint.username.c_str(), endpoint.passwd.c_str());
+    }
+    int rc = MOSQ_ERR_SUCCESS;
+    if(endpoint.port == 0) {
+        curConnectionState = connection::server;
+        rc = mosquitto_connect_srv(mqttClient.get(), endpoint.host.c_str(), endpoint.keepAlive, nullptr);
+        if(rc != MOSQ_ERR_SUCCESS) {
+            // SRV lookup failed, lets try host
+            curConnectionState = connection::host;
+            rc = mosquitto_connect_async(mqttClient.get(), endpoint.host.c_str(), 1883, endpoint.keepAlive);
+        }
+    }
+    else {
+        curConnectionState = connection::host;
+        rc = mosquitto_connect_async(mqttClient.get(), endpoint.host.c_str(), endpoint.port, endpoint.keepAlive);
+    }
+    if(rc != MOSQ_ERR_SUCCESS) {
+        // No callback will come, but network thread keeps reconnecting
+        curConnectionState = connection::error;
+        connectionError = rc;
+        failed = true;
+    }
+    mosquitto_loop_start(mqttClient.get());
+}
+
+void Broker::requestDisconnect()
+{
+    if(mqttClient) {
+        mosquitto_disconnect(mqttClient.get());
+    }
+}
+
+void Broker::disconnect()
+{
+    if(!mqttClient) {
+        return;
+    }
+    requestDisconnect();
+    mosquitto_loop_stop(mqttClient.get(), false);
+    mqttClient.reset();
+    connected = false;
+    failed = false;
+}
+
+std::string Broker::errorString() const
+{
+    std::lock_guard<std::mutex> lock(mtxCurConnectionState);
+    std::string message = tinytemplate::render("Error connecting to {{host}}:{{port}}: ",
+                                               {{"host", endpoint.host},
+                                                {"port", endpoint.port ? std::to_string(endpoint.port) : std::string()}});
+    if(curConnectionState == connection::error) {
+        message += "host unresolvable or connection failed";
+    }
+    else if(curConnectionState == connection::mqtt_error) {
+        switch(connectionError) {
+        case 1:
+            message += "connection refused (unacceptable protocol version)";
+            break;
+        case 2:
+            message += "connection refused (identifier rejected)";
+            break;
+        case 3:
+            message += "connection refused (broker unavailable)";
+            break;
+        case 4:
+            message += "connection refused (bad username or password)";
+            break;
+        case 5:
+            message += "connection refused (not authorised)";
+            break;
+        default:
+            message += "reserved error (" + std::to_string(connectionError) + ")";
+            break;
+        }
+    }
+    return message;
+}
+
+void Broker::publish(const std::string &topic, const std::string &payload, bool retain)
+{
+    mosquitto_publish(mqttClient.get(), nullptr,
+                      (endpoint.topicPrefix+topic).c_str(),
+                      payload.size(), payload.data(), endpoint.qos, retain);
+}
+
+void Broker::onMqttConnect(int rc)
+{
+    bool permanentError = false;
+    {
+        std::lock_guard<std::mutex> lock(mtxCurConnectionState);
+        connectionError = rc;
+        if(connectionError != 0) {
+            curConnectionState = connection::mqtt_error;
+            // Network thread retries refused connection, unless retrying is pointless
+            permanentError = rc == 1 || rc == 2 || rc == 4 || rc == 5;
+            if(permanentError) {
+                mosquitto_disconnect(mqttClient.get());
+            }
+        }
+        else {
+            curConnectionState = connection::connected;
+            // Clean session drops subscriptions, so (re)subscribe on every connect
+            for(auto &topic : subscriptions) {
+                mosquitto_subscribe(mqttClient.get(), nullptr, (endpoint.topicPrefix+topic).c_str(), endpoint.qos);
+            }
+        }
+        connected = curConnectionState == connection::connected;
+        failed = !connected;
+    }
+    if(permanentError) {
+        std::cerr << errorString() << ", giving up until reload" << std::endl;
+    }
+    stateHandler(*this);
+}
+
+void Broker::onMqttDisconnect(int rc)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtxCurConnectionState);
+        switch(curConnectionState) {
+        case connection::off: // What?!
+        case connection::connected:
+            if(rc == 0) {
+                curConnectionState = connection::off;
+                connectionError = 0;
+            }
+            else {
+                curConnectionState = connection::error;
+                connectionError = rc;
+            }
+            break;
+        case connection::error:
+        case connection::mqtt_error:
+            break;
+        case connection::server:
+            // Server connection failed, lets try host
+            curConnectionState = connection::host;
+            mosquitto_connect_async(mqttClient.get(), endpoint.host.c_str(), 1883, endpoint.keepAlive);
+            break;
+        case connection::host:
+            curConnectionState = connection::error;
+            connectionError = rc;
+            break;
+        }
+        connected = curConnectionState == connection::connected;
+        failed = curConnectionState == connection::error || curConnectionState == connection::mqtt_error;
+    }
+    stateHandler(*this);
+}
+
+void Broker::onMqttMessage(const mosquitto_message *message)
+{
+    std::string topic(message->topic);
+    if(topic.compare(0, endpoint.topicPrefix.size(), endpoint.topicPrefix) != 0) {
+        return;
+    }
+    messageHandler(*this, topic.substr(endpoint.topicPrefix.size()), message);
+}
+
+
+
+void Broker::onMqttConnect(mosquitto *mqtt, void *pParam, int rc)
+{
+    Broker* pThis = static_cast<Broker*>(pParam);
+    pThis->onMqttConnect(rc);
+}
+
+void Broker::onMqttDisconnect(mosquitto *mqtt, void *pParam, int rc)
+{
+    Broker* pThis = static_cast<Broker*>(pParam);
+    pThis->onMqttDisconnect(rc);
+}
+
+void Broker::onMqttMessage(mosquitto *mqtt, void *pParam, const mosquitto_message *message)
+{
+    Broker* pThis = static_cast<Broker*>(pParam);
+    pThis->onMqttMessage(message);
+}
@@ -0,0 +1,94 @@
+#ifndef BROKER_H
+#define BROKER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <mosquitto.h>
+
+/**************************
+ * Broker:
+ *  Connection to single MQTT broker.
+ *  Each broker has own mosquitto client with own network thread and queue,
+ *  so slow or dead broker does not delay publishing to the others.
+ *  Network thread keeps reconnecting until stopped, except on refusals
+ *  which can't go away by themselves (e.g. bad credentials).
+ * NOTE:
+ *  Topic prefix is prepended to every published and subscribed topic and
+ *  stripped from received topics before passing them to message handler.
+ *************************/
+class Broker
+{
+public:
+    enum class role {
+        mirror,
+        failover
+    };
+
+    struct Endpoint {
+        std::string host;
+        int port = 0; // 0 means SRV lookup
+        int keepAlive = 60;
+        std::string username;
+        std::string passwd;
+        role brokerRole = role::mirror;
+        std::string topicPrefix;
+        int qos = 0;
+    };
+
+    typedef std::function<void(Broker &broker, const std::string &topic, const struct mosquitto_message *message)> MessageHandler;
+    typedef std::function<void(Broker &broker)> StateHandler;
+
+public:
+    Broker(const Endpoint &endpoint, const std::vector<std::string> &subscriptions, MessageHandler onMessage, StateHandler onStateChanged);
+    ~Broker();
+
+    void connect();
+    void requestDisconnect();
+    void disconnect();
+
+    bool isConnected() const { return connected.load(std::memory_order_acquire); }
+    bool hasFailed() const { return failed.load(std::memory_order_acquire); }
+    role getRole() const { return endpoint.brokerRole; }
+    std::string errorString() const;
+
+    void publish(const std::string &topic, const std::string &payload, bool retain);
+
+protected:
+    void onMqttConnect(int rc);
+    void onMqttDisconnect(int rc);
+    void onMqttMessage(const struct mosquitto_message *message);
+private:
+    static void onMqttConnect(struct mosquitto *mqtt, void *pParam, int rc);
+    static void onMqttDisconnect(struct mosquitto *mqtt, void *pParam, int rc);
+    static void onMqttMessage(struct mosquitto *mqtt, void *pParam, const struct mosquitto_message *message);
+
+private:
+    Endpoint endpoint;
+    std::vector<std::string> subscriptions;
+    MessageHandler messageHandler;
+    StateHandler stateHandler;
+    std::unique_ptr<mosquitto, decltype(&mosquitto_destroy)> mqttClient;
+
+    enum class connection {
+        off,
+        server,
+        host,
+        connected,
+        mqtt_error,
+        error
+    };
+
+    connection curConnectionState;
+    int connectionError;
+    std::atomic<bool> connected;
+    std::atomic<bool> failed;
+
+    mutable std::mutex mtxCurConnectionState;
+};
+
+#endif//BROKER_H
@@ -0,0 +1,40 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <string>
+#include <vector>
+
+#include "broker.h"
+
+/**************************
+ * Configuration:
+ *  Typed and validated program configuration.
+ *  Built once by Application::parseArguments() and never modified after,
+ *  so it is safe to read from any thread without locking.
+ *************************/
+struct Configuration {
+    // Literal followed by optional per-sensor variable
+    struct TopicPart {
+        enum class variable {
+            none,
+            sensorId,
+            sensorName
+        };
+        std::string literal;
+        variable var;
+    };
+
+    std::string device;
+    std::string deviceTopic;
+    std::string sensorTopic;
+    std::string localSocket;
+    std::vector<Broker::Endpoint> brokers;
+
+    // Precomputed topics
+    std::vector<TopicPart> valueTopic; // Concatenated for every reading
+    std::string controlTopic;
+    std::string meterControlTopic;
+    std::string traceTopic;
+};
+
+#endif//CONFIG_H
@@ -1,26 +1,25 @@
 #include "helper.h"
-#include <sstream>
-#include <iomanip>
 
 std::string hexDump(const void *addr, size_t len, const std::string &desc)
 {
-    std::stringstream str;
+    static const char hexDigits[] = "0123456789abcdef";
+    std::string str;
     size_t i;
-    std::string asciiBuf;
-    unsigned char *pc = (unsigned char*)addr;
+    char asciiBuf[16];
+    const unsigned char *pc = static_cast<const unsigned char*>(addr);
+
+    // Every line is offset, 16 hex codes, and ASCII part
+    str.reserve(desc.size() + 2 + (len/16 + 1) * (8 + 16*3 + 1 + 16 + 1));
 
     // Output description if given.
     if (!desc.empty()) {
-        str << desc << ":\n";
+        str += desc;
+        str += ":\n";
     }
 
     if (len == 0) {
-        str << "  ZERO LENGTH\n";
-        return str.str();
-    }
-    if (len < 0) {
-        str << "  NEGATIVE LENGTH: " << len << std::endl;
-        return str.str();
+        str += "  ZERO LENGTH\n";
+        return str;
     }
 
     // Process every byte in the data.
@@ -30,33 +29,45 @@ std::string hexDump(const void *addr, size_t len, const std::string &desc)
         if ((i % 16) == 0) {
             // Just don't print ASCII for the zeroth line.
             if (i != 0) {
-                str << " " << asciiBuf << std::endl;
-                asciiBuf.clear();
+                str += ' ';
+                str.append(asciiBuf, 16);
+                str += '\n';
             }
 
-            // Output the offset.
-            str << std::setw(4) << std::setfill('0') << std::right << std::hex << i;
+            // Output the offset, at least 4 digits.
+            int digits = 4;
+            while (digits < 16 && (i >> (digits*4)) != 0) {
+                digits++;
+            }
+            while (digits-- > 0) {
+                str += hexDigits[(i >> (digits*4)) & 0xf];
+            }
         }
 
         // Now the hex code for the specific character.
-        str << " " << std::setw(2) << std::setfill('0') << std::right << std::hex << (uint)(pc[i]);
+        str += ' ';
+        str += hexDigits[pc[i] >> 4];
+        str += hexDigits[pc[i] & 0xf];
 
         // And store a printable ASCII character for later.
         if ((pc[i] < 0x20) || (pc[i] > 0x7e)) {
-            asciiBuf.push_back('.');
+            asciiBuf[i % 16] = '.';
         }
         else {
-            asciiBuf.push_back(pc[i]);
+            asciiBuf[i % 16] = pc[i];
         }
     }
 
     // Pad out last line if not exactly 16 characters.
+    size_t asciiLen = ((len - 1) % 16) + 1;
     while ((i % 16) != 0) {
-        str << "   ";
+        str += "   ";
         i++;
     }
 
     // And print the final ASCII bit.
-    str << " " << asciiBuf << std::endl;
-    return str.str();
+    str += ' ';
+    str.append(asciiBuf, asciiLen);
+    str += '\n';
+    return str;
 }
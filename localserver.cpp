@@ -0,0 +1,205 @@
+#include "localserver.h"
+
+#include <system_error>
+#include <iostream>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <tinytemplate.hpp>
+
+constexpr size_t LocalServer::maxQueuedBytes;
+
+LocalServer::LocalServer()
+    : fdListen(-1)
+{
+}
+
+LocalServer::~LocalServer()
+{
+    close();
+}
+
+void LocalServer::open(const std::string &path)
+{
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error(tinytemplate::render("Local socket path \"{{path}}\" is too long", {{"path", path}}));
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+
+    // Remove only stale socket left from previous run, never other files
+    // or socket of still running instance
+    struct stat st;
+    if(lstat(path.c_str(), &st) == 0) {
+        if(!S_ISSOCK(st.st_mode)) {
+            throw std::runtime_error(tinytemplate::render("Local socket path \"{{path}}\" exists and is not a socket", {{"path", path}}));
+        }
+        int fdProbe = socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+        if(fdProbe == -1) {
+            throw std::system_error(errno, std::system_category(), "Can't create local socket");
+        }
+        int ret = connect(fdProbe, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        int err = errno;
+        ::close(fdProbe);
+        if(ret == 0) {
+            throw std::runtime_error(tinytemplate::render("Local socket \"{{path}}\" is already served by another process", {{"path", path}}));
+        }
+        if(err != ECONNREFUSED) {
+            throw std::system_error(err, std::system_category(), tinytemplate::render("Can't check local socket {{path}}", {{"path", path}}));
+        }
+        unlink(path.c_str());
+    }
+
+    fdListen = socket(AF_UNIX, SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0);
+    if(fdListen == -1) {
+        throw std::system_error(errno, std::system_category(), "Can't create local socket");
+    }
+    if(bind(fdListen, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1
+            || listen(fdListen, SOMAXCONN) == -1) {
+        int err = errno;
+        ::close(fdListen);
+        fdListen = -1;
+        throw std::system_error(err, std::system_category(), tinytemplate::render("Can't listen on local socket {{path}}", {{"path", path}}));
+    }
+    socketPath = path;
+}
+
+void LocalServer::close()
+{
+    for(auto &client : clients) {
+        ::close(client.first);
+    }
+    clients.clear();
+    closeDroppedClients();
+    if(fdListen != -1) {
+        ::close(fdListen);
+        fdListen = -1;
+        unlink(socketPath.c_str());
+        socketPath.clear();
+    }
+}
+
+void LocalServer::publish(const std::string &frame)
+{
+    std::vector<int> slowClients;
+    for(auto &client : clients) {
+        bool wasEmpty = client.second.queue.empty();
+        client.second.queue.push_back(frame);
+        client.second.queuedBytes += frame.size();
+        if(client.second.queuedBytes > maxQueuedBytes) {
+            std::cerr << "Local client " << client.first << " is too slow, dropping" << std::endl;
+            slowClients.push_back(client.first);
+        }
+        else if(wasEmpty && !flushClient(client.first, client.second)) {
+            slowClients.push_back(client.first);
+        }
+    }
+    for(auto fd : slowClients) {
+        dropClient(fd);
+    }
+}
+
+void LocalServer::appendPollFds(std::vector<struct pollfd> &fds)
+{
+    closeDroppedClients();
+    if(fdListen == -1) {
+        return;
+    }
+    fds.push_back({fdListen, POLLIN, 0});
+    for(auto &client : clients) {
+        fds.push_back({client.first, static_cast<short>(client.second.queue.empty() ? POLLIN : POLLIN|POLLOUT), 0});
+    }
+}
+
+void LocalServer::processPollFd(const struct pollfd &fd)
+{
+    if(fd.fd == fdListen) {
+        if(fd.revents & (POLLERR|POLLHUP|POLLNVAL)) {
+            throw std::runtime_error("Local socket error");
+        }
+        if(fd.revents & POLLIN) {
+            acceptClients();
+        }
+        return;
+    }
+
+    auto client = clients.find(fd.fd);
+    if(client == clients.end()) {
+        return; // Already dropped
+    }
+    if(fd.revents & (POLLERR|POLLHUP|POLLNVAL)) {
+        dropClient(fd.fd);
+        return;
+    }
+    if(fd.revents & POLLIN) {
+        // Clients are not expected to send anything, just detect disconnect
+        char buf[256];
+        ssize_t ret = read(fd.fd, buf, sizeof(buf));
+        if(ret == 0 || (ret < 0 && errno != EAGAIN && errno != EINTR)) {
+            dropClient(fd.fd);
+            return;
+        }
+    }
+    if(fd.revents & POLLOUT) {
+        if(!flushClient(fd.fd, client->second)) {
+            dropClient(fd.fd);
+        }
+    }
+}
+
+void LocalServer::acceptClients()
+{
+    while(true) {
+        int fd = accept4(fdListen, nullptr, nullptr, SOCK_NONBLOCK|SOCK_CLOEXEC);
+        if(fd == -1) {
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "Error accepting local client: " << strerror(errno) << std::endl;
+            }
+            return;
+        }
+        clients[fd];
+    }
+}
+
+bool LocalServer::flushClient(int fd, Client &client)
+{
+    while(!client.queue.empty()) {
+        const std::string &frame = client.queue.front();
+        ssize_t ret = send(fd, frame.data()+client.frontOffset, frame.size()-client.frontOffset, MSG_NOSIGNAL);
+        if(ret < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return true;
+            }
+            return false;
+        }
+        client.frontOffset += ret;
+        if(client.frontOffset == frame.size()) {
+            client.queuedBytes -= frame.size();
+            client.frontOffset = 0;
+            client.queue.pop_front();
+        }
+    }
+    return true;
+}
+
+void LocalServer::dropClient(int fd)
+{
+    // Closing is deferred till next poll, so accept() can't reuse fd number
+    // while stale pollfd entries for it are still being processed
+    clients.erase(fd);
+    droppedClients.push_back(fd);
+}
+
+void LocalServer::closeDroppedClients()
+{
+    for(auto fd : droppedClients) {
+        ::close(fd);
+    }
+    droppedClients.clear();
+}
@@ -0,0 +1,58 @@
+#ifndef LOCALSERVER_H
+#define LOCALSERVER_H
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+
+/**************************
+ * LocalServer:
+ *  Unix domain socket server pushing newline-delimited frames to all
+ *  connected clients.
+ *  Sockets are non-blocking, each client has bounded output queue. Client
+ *  which queue overflows is considered too slow and disconnected.
+ * NOTE:
+ *  Not thread-safe, should be used from polling thread only.
+ *  appendPollFds() should be called before every poll(), it also closes
+ *  clients dropped during previous pass.
+ *************************/
+class LocalServer
+{
+public:
+    LocalServer();
+    ~LocalServer();
+
+    void open(const std::string &path);
+    void close();
+    bool isOpen() const { return fdListen != -1; }
+
+    void publish(const std::string &frame);
+
+    void appendPollFds(std::vector<struct pollfd> &fds);
+    void processPollFd(const struct pollfd &fd);
+
+private:
+    struct Client {
+        std::deque<std::string> queue;
+        size_t queuedBytes = 0;
+        size_t frontOffset = 0;
+    };
+
+    void acceptClients();
+    bool flushClient(int fd, Client &client);
+    void dropClient(int fd);
+    void closeDroppedClients();
+
+private:
+    static constexpr size_t maxQueuedBytes = 64*1024;
+
+    int fdListen;
+    std::string socketPath;
+    std::map<int, Client> clients;
+    std::vector<int> droppedClients;
+};
+
+#endif//LOCALSERVER_H
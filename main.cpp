@@ -9,6 +9,7 @@
 #include <poll.h>
 #include "main.h"
 
+#include <map>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -24,14 +25,62 @@
 #include <json/json.h>
 
 
+static int parseInt(const std::string &name, const std::string &value, int min, int max)
+{
+    size_t pos = 0;
+    int result = 0;
+    try {
+        result = std::stoi(value, &pos);
+    }
+    catch(const std::exception &) {
+        pos = 0;
+    }
+    if(pos == 0 || pos != value.size() || result < min || result > max) {
+        throw std::runtime_error(tinytemplate::render("Invalid {{name}} value \"{{value}}\"", {{"name", name}, {"value", value}}));
+    }
+    return result;
+}
+
+static std::vector<Configuration::TopicPart> splitTopic(const std::string &topic)
+{
+    static const std::string sensorIdVar = "{{sensorId}}";
+    static const std::string sensorNameVar = "{{sensorName}}";
+    std::vector<Configuration::TopicPart> parts;
+    size_t start = 0;
+    while(true) {
+        size_t idPos = topic.find(sensorIdVar, start);
+        size_t namePos = topic.find(sensorNameVar, start);
+        if(idPos == std::string::npos && namePos == std::string::npos) {
+            break;
+        }
+        bool isId = idPos < namePos;
+        size_t pos = isId ? idPos : namePos;
+        parts.push_back({topic.substr(start, pos-start), isId ? Configuration::TopicPart::variable::sensorId : Configuration::TopicPart::variable::sensorName});
+        start = pos + (isId ? sensorIdVar.size() : sensorNameVar.size());
+    }
+    parts.push_back({topic.substr(start), Configuration::TopicPart::variable::none});
+    return parts;
+}
+
+static bool lookupString(const libconfig::Setting &setting, const char *name, std::string &value)
+{
+    int intValue;
+    if(setting.lookupValue(name, value)) {
+        return true;
+    }
+    if(setting.lookupValue(name, intValue)) {
+        value = std::to_string(intValue);
+        return true;
+    }
+    return false;
+}
+
 Application::Application(int argc, char *argv[])
     : argc(argc)
     , argv(argv)
     , fdDevice(-1)
     , fdSignal(-1)
-    , mqttClient(nullptr, &mosquitto_destroy)
-    , curConnectionState(connection::off)
-    , connectionError(0)
+    , config(nullptr)
 {
     mosquitto_lib_init();
 }
@@ -40,7 +89,7 @@ Application::~Application()
 {
     closeSignal();
     closeDevice();
-    mqttClient.reset();
+    brokers.clear();
     mosquitto_lib_cleanup();
 }
 
@@ -55,6 +104,7 @@ void Application::Run()
         openDevice();
         openSignal();
         openMQTT();
+        openLocalSocket();
 
         std::cout << "Start processing" << std::endl;
 
@@ -62,6 +112,7 @@ void Application::Run()
 
         std::cout << "Closing..." << std::endl;
 
+        closeLocalSocket();
         closeMQTT();
         closeSignal();
         closeDevice();
@@ -71,48 +122,59 @@ void Application::Run()
 
 void Application::parseArguments()
 {
-    options = {
+    std::map<std::string, std::string> options = {
         {"device",""},
         {"device-topic","/home/meterDigitizer"},
         {"sensor-topic","{{sensorId}}"},
         {"host", "localhost"},
-        {"keep-alive", "60"}
+        {"port", ""},
+        {"keep-alive", "60"},
+        {"username", ""},
+        {"passwd", ""},
+        {"local-socket", ""}
     };
 
     const std::vector<std::string> defaultConfigPaths = {"/etc/meterDigitizer-mqtt.conf", "~/.config/meterDigitizer-mqtt.conf", "~/.meterDigitizer-mqtt"};
     std::map<std::string, std::string> arguments;
+    std::vector<std::map<std::string, std::string>> brokerSettings;
 
     const struct option long_options[] = {
         {"device", required_argument, nullptr, 'd'},
         {"device-topic", required_argument, nullptr, 't'},
         {"sensor-topic", required_argument, nullptr, 's'},
+        {"host", required_argument, nullptr, 'h'},
+        {"port", required_argument, nullptr, 'p'},
+        {"keep-alive", required_argument, nullptr, 'k'},
+        {"username", required_argument, nullptr, 'u'},
+        {"passwd", required_argument, nullptr, 'P'},
         {"config", required_argument, nullptr, 'c'},
+        {"local-socket", required_argument, nullptr, 'l'},
         {nullptr, 0, NULL, 0}
     };
 
     std::vector<std::string> configPaths = defaultConfigPaths;
 
+    // Arguments are parsed again on every reload
+    optind = 0;
     int option_index;
     int c;
-    while((c = getopt_long(argc, argv, "d:t:s:c:", long_options, &option_index)) != -1) {
+    while((c = getopt_long(argc, argv, "d:t:s:h:p:k:u:P:c:l:", long_options, &option_index)) != -1) {
         switch (c) {
-        case 'd':
-            arguments["device"] = optarg;
-            break;
-        case 't':
-            arguments["device-topic"] = optarg;
-            break;
-        case 's':
-            arguments["sensor-topic"] = optarg;
-            break;
         case 'c':
             configPaths.push_back(optarg);
             break;
         case '?':
             /* getopt_long already printed an error message. */
             break;
-        default:
-            throw std::runtime_error("arguments error");
+        default: {
+            // All other options are stored under their long name
+            auto opt = std::find_if(std::begin(long_options), std::end(long_options), [c](const struct option &o){ return o.name && o.val == c; });
+            if(opt == std::end(long_options)) {
+                throw std::runtime_error("arguments error");
+            }
+            arguments[opt->name] = optarg;
+            break;
+        }
         }
     }
 
@@ -124,7 +186,21 @@ void Application::parseArguments()
                 libconfig::Config cfg;
                 cfg.readFile(we.we_wordv[i]);
                 for(auto &option : options) {
-                    cfg.lookupValue(option.first, option.second);
+                    lookupString(cfg.getRoot(), option.first.c_str(), option.second);
+                }
+                if(cfg.exists("brokers")) {
+                    const libconfig::Setting &brokerList = cfg.lookup("brokers");
+                    brokerSettings.clear();
+                    for(int j = 0; j < brokerList.getLength(); ++j) {
+                        std::map<std::string, std::string> settings;
+                        for(auto name : {"host", "port", "keep-alive", "username", "passwd", "role", "topic-prefix", "qos"}) {
+                            std::string value;
+                            if(lookupString(brokerList[j], name, value)) {
+                                settings[name] = value;
+                            }
+                        }
+                        brokerSettings.push_back(settings);
+                    }
                 }
             }
             wordfree(&we);
@@ -148,22 +224,78 @@ void Application::parseArguments()
         options[args.first] = args.second;
     }
 
-    if(options["device"].empty()) {
+    std::unique_ptr<Configuration> newConfig(new Configuration);
+    newConfig->device = options["device"];
+    newConfig->deviceTopic = options["device-topic"];
+    newConfig->sensorTopic = options["sensor-topic"];
+    newConfig->localSocket = options["local-socket"];
+
+    if(newConfig->device.empty()) {
         throw std::runtime_error("No device specified");
     }
-    if(options["device-topic"].empty()) {
+    if(newConfig->deviceTopic.empty()) {
         throw std::runtime_error("No device topic specified");
     }
-    if(options["sensor-topic"].empty()) {
+    if(newConfig->sensorTopic.empty()) {
         throw std::runtime_error("No sensor topic specified");
     }
+
+    // Without "brokers" section top-level options describe the only broker
+    if(brokerSettings.empty()) {
+        brokerSettings.push_back({});
+    }
+    for(auto &settings : brokerSettings) {
+        auto value = [&settings](const std::string &name, const std::string &defaultValue) {
+            auto it = settings.find(name);
+            return it != settings.end() ? it->second : defaultValue;
+        };
+        Broker::Endpoint endpoint;
+        endpoint.host = value("host", options["host"]);
+        std::string port = value("port", options["port"]);
+        endpoint.port = port.empty() ? 0 : parseInt("port", port, 1, 65535);
+        endpoint.keepAlive = parseInt("keep-alive", value("keep-alive", options["keep-alive"]), 5, 65535);
+        endpoint.username = value("username", options["username"]);
+        endpoint.passwd = value("passwd", options["passwd"]);
+        endpoint.topicPrefix = value("topic-prefix", "");
+        endpoint.qos = parseInt("qos", value("qos", "0"), 0, 2);
+        std::string role = value("role", "mirror");
+        if(role == "mirror") {
+            endpoint.brokerRole = Broker::role::mirror;
+        }
+        else if(role == "failover") {
+            endpoint.brokerRole = Broker::role::failover;
+        }
+        else {
+            throw std::runtime_error(tinytemplate::render("Unknown broker role \"{{role}}\"", {{"role", role}}));
+        }
+        if(endpoint.host.empty()) {
+            throw std::runtime_error("No host specified");
+        }
+        newConfig->brokers.push_back(endpoint);
+    }
+
+    // Render everything except per-sensor variables once, not for every reading
+    std::map<std::string, std::string> renderVars = options;
+    renderVars["sensorId"] = "{{sensorId}}";
+    renderVars["sensorName"] = "{{sensorName}}";
+    std::string valueTopic = tinytemplate::render("{{device-topic}}/{{sensor-topic}}/value", renderVars);
+    newConfig->valueTopic = splitTopic(tinytemplate::render(valueTopic, renderVars));
+    newConfig->controlTopic = newConfig->deviceTopic+"/control";
+    newConfig->meterControlTopic = newConfig->deviceTopic+"/+/control";
+    newConfig->traceTopic = newConfig->deviceTopic+"/trace";
+
+    // Configuration is replaced only while broker threads are stopped,
+    // so the previous one may be released right after the swap
+    config.store(newConfig.get(), std::memory_order_release);
+    configStorage = std::move(newConfig);
 }
 
 void Application::openDevice()
 {
-    fdDevice = open(options["device"].c_str(), O_RDWR|O_NOCTTY);
+    const Configuration &cfg = getConfig();
+    fdDevice = open(cfg.device.c_str(), O_RDWR|O_NOCTTY);
     if(fdDevice == -1) {
-        throw std::system_error(errno, std::system_category(), tinytemplate::render("Can't open device {{device}}", {{"device", options["device"]}}));
+        throw std::system_error(errno, std::system_category(), tinytemplate::render("Can't open device {{device}}", {{"device", cfg.device}}));
     }
 }
 
@@ -185,71 +317,60 @@ void Application::openSignal()
 
 void Application::openMQTT()
 {
-    mqttClient.reset(mosquitto_new(nullptr, true, this));
-    mosquitto_reinitialise(mqttClient.get(), nullptr, true, this);
-
-    mosquitto_connect_callback_set(mqttClient.get(), &Application::onMqttConnect);
-    mosquitto_disconnect_callback_set(mqttClient.get(), &Application::onMqttDisconnect);
-    mosquitto_publish_callback_set(mqttClient.get(), &Application::onMqttPublish);
-    mosquitto_message_callback_set(mqttClient.get(), &Application::onMqttMessage);
-    mosquitto_subscribe_callback_set(mqttClient.get(), &Application::onMqttSubscribe);
-    mosquitto_unsubscribe_callback_set(mqttClient.get(), &Application::onMqttUnSubscribe);
-    mosquitto_log_callback_set(mqttClient.get(), &Application::onMqttLog);
-
-
-
-    if(!options["username"].empty()) {
-        mosquitto_username_pw_set(mqttClient.get(), options["username"].c_str(), options["passwd"].c_str());
+    const Configuration &cfg = getConfig();
+    const std::vector<std::string> subscriptions = {cfg.meterControlTopic, cfg.controlTopic};
+    for(auto &endpoint : cfg.brokers) {
+        brokers.emplace_back(new Broker(endpoint, subscriptions,
+                                        [this](Broker &broker, const std::string &topic, const mosquitto_message *message){
+            onMqttMessage(broker, topic, message);},
+                                        [this](Broker &){
+            std::lock_guard<std::mutex> lock(mtxBrokerState);
+            cvBrokerState.notify_all();}));
+        brokers.back()->connect();
     }
-    if(options["port"].empty()) {
-        curConnectionState = connection::server;
-        mosquitto_connect_srv(mqttClient.get(), options["host"].c_str(), std::stoi(options["keep-alive"]), nullptr);
+
+    // Start as soon as any broker is connected, the rest connect in background
+    std::unique_lock<std::mutex> lock(mtxBrokerState);
+    cvBrokerState.wait(lock, [this](){
+        return std::any_of(brokers.begin(), brokers.end(), [](const std::unique_ptr<Broker> &broker){ return broker->isConnected(); })
+            || std::all_of(brokers.begin(), brokers.end(), [](const std::unique_ptr<Broker> &broker){ return broker->hasFailed(); });
+    });
+    lock.unlock();
+
+    bool anyConnected = false;
+    for(auto &broker : brokers) {
+        if(broker->isConnected()) {
+            anyConnected = true;
+        }
+        else if(broker->hasFailed() && brokers.size() > 1) {
+            std::cerr << broker->errorString() << std::endl;
+        }
     }
-    else {
-        curConnectionState = connection::host;
-        mosquitto_connect_async(mqttClient.get(), options["host"].c_str(), std::stoi(options["port"]), std::stoi(options["keep-alive"]));
+    if(!anyConnected) {
+        throw std::runtime_error(brokers.size() == 1 ? brokers.front()->errorString() : "Can't connect to any MQTT broker");
     }
-    mosquitto_loop_start(mqttClient.get());
-
+}
 
-    {
-        std::unique_lock<std::mutex> lock(mtxCurConnectionState);
-        cvCurConnectionState.wait(lock, [this](){
-            return curConnectionState == connection::connected || curConnectionState == connection::error || curConnectionState == connection::mqtt_error;});
-        if(curConnectionState == connection::error || curConnectionState == connection::mqtt_error) {
-            std::string message = tinytemplate::render("Error connecting to {{host}}:{{port}}: ", options);
-            if(curConnectionState == connection::error) {
-                message += "host unresolvable or connection failed";
-            }
-            else if(curConnectionState == connection::mqtt_error) {
-                switch(connectionError) {
-                case 1:
-                    message += "connection refused (unacceptable protocol version)";
-                    break;
-                case 2:
-                    message += "connection refused (identifier rejected)";
-                    break;
-                case 3:
-                    message += "connection refused (broker unavailable)";
-                    break;
-                default:
-                    message += "reserved error (" + std::to_string(connectionError) + ")";
-                    break;
-                }
-            }
-            throw std::runtime_error(message);
-        }
+void Application::openLocalSocket()
+{
+    const Configuration &cfg = getConfig();
+    if(!cfg.localSocket.empty()) {
+        localServer.open(cfg.localSocket);
     }
+}
 
-    mosquitto_subscribe(mqttClient.get(), nullptr, (options["device-topic"]+"/+/control").c_str(),0);
-    mosquitto_subscribe(mqttClient.get(), nullptr, (options["device-topic"]+"/control").c_str(),0);
+void Application::closeLocalSocket()
+{
+    localServer.close();
 }
 
 void Application::closeMQTT()
 {
-    mosquitto_disconnect(mqttClient.get());
-    mosquitto_loop_stop(mqttClient.get(), false);
-    mqttClient.reset();
+    // Let all network threads wind down at once, then join them
+    for(auto &broker : brokers) {
+        broker->requestDisconnect();
+    }
+    brokers.clear();
 }
 
 void Application::closeDevice()
@@ -270,9 +391,11 @@ void Application::closeSignal()
 
 bool Application::pollingLoop()
 {
-    std::array<struct pollfd, 2> fds = {{{fdDevice, POLLIN, 0}, {fdSignal, POLLIN, 0}}};
+    std::vector<struct pollfd> fds;
     std::string serialData;
     while(true) {
+        fds = {{fdDevice, POLLIN, 0}, {fdSignal, POLLIN, 0}};
+        localServer.appendPollFds(fds);
         int pollRet = poll(fds.data(), fds.size(), -1);
         if(pollRet < 0) {
             if(errno != EINTR) {
@@ -284,6 +407,13 @@ bool Application::pollingLoop()
         }
         else {
             for(auto fd : fds) {
+                if(fd.revents == 0) {
+                    continue;
+                }
+                if(fd.fd != fdDevice && fd.fd != fdSignal) {
+                    localServer.processPollFd(fd);
+                    continue;
+                }
                 if(fd.revents & (POLLERR|POLLHUP|POLLNVAL)) {
                     if(fd.fd == fdDevice) {
                         throw std::runtime_error("Device file error");
@@ -304,14 +434,21 @@ bool Application::pollingLoop()
                         case signal_action::reload:
                             std::cout << "Reload signal detected" << std::endl;
                             return true;
+                        case signal_action::dump:
+                            std::cerr << trace.dump() << std::flush;
+                            break;
                         case signal_action::ignore:
                             break;
                         }
                     }
                     else if(fd.fd == fdDevice) {
-                        char ch;
-                        ssize_t ret = read(fdDevice, &ch, 1);
-                        if(ret == 1) {
+                        char buf[256];
+                        ssize_t ret = read(fdDevice, buf, sizeof(buf));
+                        if(ret > 0) {
+                            trace.record(TraceBuffer::kind::serial_in, buf, ret);
+                        }
+                        for(ssize_t i = 0; i < ret; ++i) {
+                            char ch = buf[i];
                             if(ch == '\n') {
                                 if(!serialData.empty() && serialData.back() == '\r') {
                                     serialData.pop_back();
@@ -345,15 +482,44 @@ void Application::processSerialData(const std::string &data)
     jsonMsg["id"] = splittedData[1];
     jsonMsg["name"] = splittedData[2];
     jsonMsg["value"] = splittedData[3];
-    std::map<std::string, std::string> renderVars = options;
-    renderVars["sensorId"] = jsonMsg["id"].asString();
-    renderVars["sensorName"] = jsonMsg["name"].asString();
     std::string mqttPayload = Json::FastWriter().write(jsonMsg);
-    std::string mqttTopicName = tinytemplate::render("{{device-topic}}/{{sensor-topic}}/value",renderVars);
-    mqttTopicName = tinytemplate::render(mqttTopicName, renderVars);
-    mosquitto_publish(mqttClient.get(), nullptr,
-                      mqttTopicName.c_str(),
-                      mqttPayload.size(), mqttPayload.data(), 0, true);
+    std::string mqttTopicName;
+    for(auto &part : getConfig().valueTopic) {
+        mqttTopicName += part.literal;
+        switch(part.var) {
+        case Configuration::TopicPart::variable::sensorId:
+            mqttTopicName += splittedData[1];
+            break;
+        case Configuration::TopicPart::variable::sensorName:
+            mqttTopicName += splittedData[2];
+            break;
+        case Configuration::TopicPart::variable::none:
+            break;
+        }
+    }
+    trace.record(TraceBuffer::kind::mqtt_out, mqttTopicName, mqttPayload.data(), mqttPayload.size());
+    bool failoverPublished = false;
+    for(auto &broker : brokers) {
+        if(broker->getRole() == Broker::role::mirror) {
+            broker->publish(mqttTopicName, mqttPayload, true);
+        }
+        else if(!failoverPublished && broker->isConnected()) {
+            // Failover brokers are tried in configuration order
+            broker->publish(mqttTopicName, mqttPayload, true);
+            failoverPublished = true;
+        }
+    }
+    if(!failoverPublished) {
+        // No failover broker is connected, let the first one queue the reading
+        auto firstFailover = std::find_if(brokers.begin(), brokers.end(), [](const std::unique_ptr<Broker> &broker){ return broker->getRole() == Broker::role::failover; });
+        if(firstFailover != brokers.end()) {
+            (*firstFailover)->publish(mqttTopicName, mqttPayload, true);
+        }
+    }
+    if(localServer.isOpen()) {
+        // FastWriter output is already newline-terminated
+        localServer.publish(mqttPayload);
+    }
 }
 
 Application::signal_action Application::processSignal()
@@ -368,57 +534,20 @@ Application::signal_action Application::processSignal()
         return signal_action::quit;
     case SIGHUP:
         return signal_action::reload;
+    case SIGUSR1:
+        return signal_action::dump;
     default:
         return signal_action::ignore;
     }
 }
 
-void Application::onMqttConnect(int rc)
-{
-    std::lock_guard<std::mutex> lock(mtxCurConnectionState);
-    curConnectionState = connection::connected;
-    connectionError = rc;
-    if(connectionError != 0) {
-        mosquitto_disconnect(mqttClient.get());
-    }
-    cvCurConnectionState.notify_all();
-}
-
-void Application::onMqttDisconnect(int rc)
+void Application::onMqttMessage(Broker &broker, const std::string &topic, const mosquitto_message *message)
 {
-    std::lock_guard<std::mutex> lock(mtxCurConnectionState);
-    switch(curConnectionState) {
-    case connection::off: // What?!
-    case connection::connected:
-        if(rc == 0) {
-            curConnectionState = connection::off;
-            connectionError = 0;
-        }
-        else {
-            curConnectionState = connection::error;
-            connectionError = rc;
-        }
-        break;
-    case connection::error:
-    case connection::mqtt_error:
-        break;
-    case connection::server:
-        // Server connection failed, lets try host
-        curConnectionState = connection::host;
-        mosquitto_connect_async(mqttClient.get(), options["host"].c_str(), 1883, std::stoi(options["keep-alive"]));
-        break;
-    case connection::host:
-        curConnectionState = connection::error;
-        connectionError = rc;
-        break;
-    }
-    cvCurConnectionState.notify_all();
-}
+    trace.record(TraceBuffer::kind::mqtt_in, message->topic, strlen(message->topic), message->payload, message->payloadlen);
 
-void Application::onMqttMessage(const mosquitto_message *message)
-{
+    const Configuration &cfg = getConfig();
     bool match = false;
-    mosquitto_topic_matches_sub((options["device-topic"]+"/control").c_str(), message->topic, &match);
+    mosquitto_topic_matches_sub(cfg.controlTopic.c_str(), topic.c_str(), &match);
     if(match) {
         if(!message->payload) {
             return;
@@ -429,6 +558,7 @@ void Application::onMqttMessage(const mosquitto_message *message)
         Json::Value jsonTime = payload.get("time", Json::Value());
         if(!jsonTime.isNull()) {
             std::string setTimeCmd = tinytemplate::render("SET TIME {{time}}\r",{{"time",jsonTime.asString()}});
+            trace.record(TraceBuffer::kind::serial_out, setTimeCmd.data(), setTimeCmd.size());
             ssize_t ret = write(fdDevice, setTimeCmd.data(), setTimeCmd.size());
             if(ret != (ssize_t)setTimeCmd.size()) {
                 std::cerr << "Error sending command \"" << setTimeCmd << "\"" << std::endl;
@@ -437,22 +567,27 @@ void Application::onMqttMessage(const mosquitto_message *message)
         Json::Value jsonList = payload.get("list", Json::Value());
         if(!jsonList.isNull()){
             std::string listCmd("LIST\r");
+            trace.record(TraceBuffer::kind::serial_out, listCmd.data(), listCmd.size());
             ssize_t ret = write(fdDevice, listCmd.data(), listCmd.size());
             if(ret != (ssize_t)listCmd.size()) {
                 std::cerr << "Error sending command \"" << listCmd << "\"" << std::endl;
             }
         }
+        Json::Value jsonTrace = payload.get("trace", Json::Value());
+        if(!jsonTrace.isNull()) {
+            broker.publish(cfg.traceTopic, trace.dump(), false);
+        }
         return;
     }
 
-    mosquitto_topic_matches_sub((options["device-topic"]+"/+/control").c_str(), message->topic, &match);
+    mosquitto_topic_matches_sub(cfg.meterControlTopic.c_str(), topic.c_str(), &match);
     if(match) {
         if(!message->payload) {
             return;
         }
         char **topics;
         int topic_count;
-        mosquitto_sub_topic_tokenise(message->topic, &topics, &topic_count);
+        mosquitto_sub_topic_tokenise(topic.c_str(), &topics, &topic_count);
         int deviceId = std::stoi(topics[topic_count-2]);
         mosquitto_sub_topic_tokens_free(&topics, topic_count);
         std::istringstream dataStream(std::string((char*)message->payload, message->payloadlen));
@@ -462,6 +597,7 @@ void Application::onMqttMessage(const mosquitto_message *message)
         if(!jsonVal.isNull() && jsonVal.isConvertibleTo(Json::realValue)) {
             char cmd[256];
             std::sprintf(cmd, "SET METER %d %.3f\r", deviceId, jsonVal.asFloat());
+            trace.record(TraceBuffer::kind::serial_out, cmd, strlen(cmd));
             ssize_t ret = write(fdDevice, cmd, strlen(cmd));
             if(ret != (ssize_t)strlen(cmd)) {
                 std::cerr << "Error sending command \"" << cmd << "\"" << std::endl;
@@ -470,54 +606,6 @@ void Application::onMqttMessage(const mosquitto_message *message)
     }
 }
 
-void Application::onMqttLog(int level, const std::string &str)
-{
-}
-
-
-
-void Application::onMqttConnect(mosquitto *mqtt, void *pParam, int rc)
-{
-    Application* pThis = static_cast<Application*>(pParam);
-    pThis->onMqttConnect(rc);
-}
-
-void Application::onMqttDisconnect(mosquitto *mqtt, void *pParam, int rc)
-{
-    Application* pThis = static_cast<Application*>(pParam);
-    pThis->onMqttDisconnect(rc);
-}
-
-void Application::onMqttPublish(mosquitto *mqtt, void *pParam, int mid)
-{
-    Application* pThis = static_cast<Application*>(pParam);
-    pThis->onMqttPublish(mid);
-}
-
-void Application::onMqttMessage(mosquitto *mqtt, void *pParam, const mosquitto_message *message)
-{
-    Application* pThis = static_cast<Application*>(pParam);
-    pThis->onMqttMessage(message);
-}
-
-void Application::onMqttSubscribe(mosquitto *mqtt, void *pParam, int mid, int qos_count, const int *granted_qos)
-{
-    Application* pThis = static_cast<Application*>(pParam);
-    pThis->onMqttSubscribe(mid, std::vector<int>(granted_qos, granted_qos+qos_count));
-}
-
-void Application::onMqttUnSubscribe(mosquitto *mqtt, void *pParam, int mid)
-{
-    Application* pThis = static_cast<Application*>(pParam);
-    pThis->onMqttUnSubscribe(mid);
-}
-
-void Application::onMqttLog(mosquitto *mqtt, void *pParam, int level, const char *str)
-{
-    Application* pThis = static_cast<Application*>(pParam);
-    pThis->onMqttLog(level, str);
-}
-
 int main(int argc, char *argv[])
 {
     try {
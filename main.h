@@ -1,12 +1,16 @@
 #ifndef APPLICATION_H
 #define APPLICATION_H
 
-#include <map>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <condition_variable>
 
-#include <mosquitto.h>
+#include "broker.h"
+#include "config.h"
+#include "trace.h"
+#include "localserver.h"
 
 class Application
 {
@@ -20,16 +24,20 @@ protected:
     enum class signal_action {
         ignore,
         reload,
+        dump,
         quit
     };
 
 protected:
     void parseArguments();
+    const Configuration &getConfig() const { return *config.load(std::memory_order_acquire); }
 
     void openDevice();
     void openSignal();
     void openMQTT();
+    void openLocalSocket();
 
+    void closeLocalSocket();
     void closeMQTT();
     void closeDevice();
     void closeSignal();
@@ -39,44 +47,21 @@ protected:
     void processSerialData(const std::string &data);
     signal_action processSignal();
 protected:
-    void onMqttConnect(int rc);
-    void onMqttDisconnect(int rc);
-    void onMqttPublish(int mid) { }
-    void onMqttMessage(const struct mosquitto_message *message);
-    void onMqttSubscribe(int mid, const std::vector<int> &granted_qos) { }
-    void onMqttUnSubscribe(int mid) { }
-    void onMqttLog(int level, const std::string &str);
-private:
-    static void onMqttConnect(struct mosquitto *mqtt, void *pParam, int rc);
-    static void onMqttDisconnect(struct mosquitto *mqtt, void *pParam, int rc);
-    static void onMqttPublish(struct mosquitto *mqtt, void *pParam, int mid);
-    static void onMqttMessage(struct mosquitto *mqtt, void *pParam, const struct mosquitto_message *message);
-    static void onMqttSubscribe(struct mosquitto *mqtt, void *pParam, int mid, int qos_count, const int *granted_qos);
-    static void onMqttUnSubscribe(struct mosquitto *mqtt, void *pParam, int mid);
-    static void onMqttLog(struct mosquitto *mqtt, void *pParam, int level, const char *str);
+    void onMqttMessage(Broker &broker, const std::string &topic, const struct mosquitto_message *message);
 
 private:
     int argc;
     char **argv;
     int fdDevice;
     int fdSignal;
-    std::map<std::string, std::string> options;
-    std::unique_ptr<mosquitto, decltype(&mosquitto_destroy)> mqttClient;
-
-    enum class connection {
-        off,
-        server,
-        host,
-        connected,
-        mqtt_error,
-        error
-    };
-
-    connection curConnectionState;
-    int connectionError;
-
-    std::mutex mtxCurConnectionState;
-    std::condition_variable cvCurConnectionState;
+    std::unique_ptr<const Configuration> configStorage;
+    std::atomic<const Configuration*> config;
+    std::vector<std::unique_ptr<Broker>> brokers;
+    std::mutex mtxBrokerState;
+    std::condition_variable cvBrokerState;
+
+    TraceBuffer trace;
+    LocalServer localServer;
 };
 
 
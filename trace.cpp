@@ -0,0 +1,89 @@
+#include "trace.h"
+#include "helper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+constexpr size_t TraceBuffer::slotCount;
+constexpr size_t TraceBuffer::slotDataSize;
+
+TraceBuffer::TraceBuffer()
+    : head(0)
+{
+    for(auto &slot : slots) {
+        slot.seq.store(0, std::memory_order_relaxed);
+    }
+}
+
+void TraceBuffer::record(kind type, const char *topic, size_t topicLen, const void *data, size_t len)
+{
+    uint64_t idx = head.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots[idx % slotCount];
+
+    // Odd sequence marks slot as being written
+    slot.seq.store(2*idx+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    slot.type = type;
+    slot.topicLen = std::min(topicLen, slotDataSize);
+    slot.dataLen = len;
+    // Serial records have no topic and MQTT payload may be NULL
+    if(slot.topicLen) {
+        std::memcpy(slot.data, topic, slot.topicLen);
+    }
+    if(len) {
+        std::memcpy(slot.data+slot.topicLen, data, std::min(len, slotDataSize-slot.topicLen));
+    }
+
+    slot.seq.store(2*idx+2, std::memory_order_release);
+}
+
+std::string TraceBuffer::dump() const
+{
+    static const char *kindNames[] = {"serial-in", "serial-out", "mqtt-in", "mqtt-out"};
+
+    std::string str;
+    uint64_t last = head.load(std::memory_order_acquire);
+    uint64_t first = last > slotCount ? last - slotCount : 0;
+    for(uint64_t idx = first; idx < last; ++idx) {
+        const Slot &slot = slots[idx % slotCount];
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if(seq != 2*idx+2) {
+            continue; // Still being written or already overwritten
+        }
+        int64_t timestamp = slot.timestamp;
+        kind type = slot.type;
+        size_t topicLen = slot.topicLen;
+        size_t dataLen = slot.dataLen;
+        char data[slotDataSize];
+        std::memcpy(data, slot.data, sizeof(data));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(slot.seq.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+
+        time_t seconds = timestamp / 1000000;
+        struct tm tm;
+        char timeBuf[64];
+        localtime_r(&seconds, &tm);
+        size_t timeLen = strftime(timeBuf, sizeof(timeBuf), "%F %T", &tm);
+        snprintf(timeBuf+timeLen, sizeof(timeBuf)-timeLen, ".%06d", (int)(timestamp % 1000000));
+
+        size_t storedLen = std::min(dataLen, slotDataSize-topicLen);
+        std::string desc = std::string(timeBuf) + " " + kindNames[static_cast<size_t>(type)];
+        if(topicLen) {
+            desc += " " + std::string(data, topicLen);
+        }
+        desc += " (" + std::to_string(dataLen) + " bytes";
+        if(storedLen != dataLen) {
+            desc += ", truncated";
+        }
+        desc += ")";
+        str += hexDump(data+topicLen, storedLen, desc);
+    }
+    return str;
+}
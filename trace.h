@@ -0,0 +1,52 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**************************
+ * TraceBuffer:
+ *  Fixed-size lock-free ring of raw serial and MQTT traffic.
+ *  record() only copies bytes into a slot, so it is cheap enough to keep
+ *  always on. Formatting is done by dump() on demand.
+ * NOTE:
+ *  Records longer than slot capacity are truncated, original length is kept.
+ *************************/
+class TraceBuffer
+{
+public:
+    enum class kind : uint8_t {
+        serial_in,
+        serial_out,
+        mqtt_in,
+        mqtt_out
+    };
+
+    TraceBuffer();
+
+    void record(kind type, const void *data, size_t len) { record(type, nullptr, 0, data, len); }
+    void record(kind type, const std::string &topic, const void *data, size_t len) { record(type, topic.data(), topic.size(), data, len); }
+    void record(kind type, const char *topic, size_t topicLen, const void *data, size_t len);
+
+    std::string dump() const;
+
+private:
+    static constexpr size_t slotCount = 256;
+    static constexpr size_t slotDataSize = 240;
+
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        int64_t timestamp;
+        kind type;
+        uint16_t topicLen;
+        uint32_t dataLen;
+        char data[slotDataSize];
+    };
+
+    std::atomic<uint64_t> head;
+    std::array<Slot, slotCount> slots;
+};
+
+#endif//TRACE_H